@@ -10,24 +10,43 @@
  * - Jogador navega interativamente: esquerda (e), direita (d) ou sair (s).
  * - Ao final, lista pistas coletadas e pede o acusado; vence se ao menos
  *   duas pistas apontarem para o mesmo suspeito.
+ * - Opcional: grava cada sessão como linha "movimentos;acusado" em um
+ *   registro (--gravar) e analisa registros grandes em paralelo (--analisar).
+ * - Opcional: compara as estruturas otimizadas com as de referência em
+ *   sessões e cenários aleatórios, medindo a vazão de cada uma (--comparar).
  *
  * Autor: Enigma Studios (implementação solicitada por usuário)
  */
 
+#define _FILE_OFFSET_BITS 64     /* fseeko/ftello com registros > 2 GB */
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
 
 /* ----------- DEFINIÇÕES BÁSICAS ------------- */
 
 #define HASH_SIZE 101  /* tamanho da tabela hash (primo razoável) */
+#define TAM_BLOCO_LEITURA (1 << 20)  /* bytes lidos por vez na análise */
+#define MAX_THREADS 64
+#define LOTE_COMPARACAO 4096   /* sessões por lote em --comparar */
+#define MAX_MOVIMENTOS 40      /* movimentos por sessão gerada (> altura máxima) */
+#define SESSOES_POR_CENARIO 1024  /* sessões por cenário gerado em --comparar */
+#define SEM_PISTA (-1)         /* sala sem pista em Cenario.pistaDaSala */
+#define MAX_ITENS_CENARIO 32   /* limite de salas/pistas (bitmasks de 32 bits) */
 
 /* Estrutura de uma sala (nó da árvore da mansão) */
 typedef struct Sala {
-    char *nome;             /* identificador único do cômodo */
-    struct Sala *esq;       /* filho esquerdo */
-    struct Sala *dir;       /* filho direito */
+    const char *nome;         /* identificador único do cômodo */
+    const struct Sala *esq;   /* filho esquerdo */
+    const struct Sala *dir;   /* filho direito */
 } Sala;
 
 /* Nó da BST para armazenar pistas coletadas */
@@ -39,16 +58,42 @@ typedef struct PistaNode {
 
 /* Item para lista encadeada usada na tabela hash (chave: pista -> valor: suspeito) */
 typedef struct HashItem {
-    char *pista;
-    char *suspeito;
-    struct HashItem *prox;
+    const char *pista;
+    const char *suspeito;
+    const struct HashItem *prox;
 } HashItem;
 
-/* Tabela hash */
+/* Tabela hash. Os campos são const para que a tabela do cenário embutido
+ * possa ser const; as funções que alocam/liberam itens (inserirNaHash,
+ * liberarHash) só são usadas com tabelas montadas em tempo de execução.
+ */
 typedef struct {
-    HashItem *buckets[HASH_SIZE];
+    const HashItem *buckets[HASH_SIZE];
 } HashTable;
 
+/* Cenário jogável: mapa, pistas e tabela hash já montados.
+ * salas[0] é a entrada; pistaDaSala[i] é o índice em pistas da pista da
+ * sala i (ou SEM_PISTA). nSalas e nPistas vão até MAX_ITENS_CENARIO.
+ */
+typedef struct {
+    const char *titulo;
+    const Sala *salas;
+    int nSalas;
+    const int *pistaDaSala;
+    const HashItem *pistas;
+    int nPistas;
+    const HashTable *hash;
+} Cenario;
+
+/* Resumo de uma partida, devolvido ao main para gravar no registro.
+ * Como a exploração só desce na árvore, há no máximo nSalas-1 movimentos.
+ */
+typedef struct {
+    char movimentos[MAX_ITENS_CENARIO + 1];
+    size_t nMovimentos;
+    char acusado[128];      /* vazio se não houve acusação */
+} Sessao;
+
 /* ----------- UTILITÁRIOS DE STRINGS --------- */
 
 /* strdup portátil */
@@ -67,8 +112,10 @@ static void str_to_lower(char *s) {
 
 /* ----------- HASH (djb2) -------------------- */
 
-static unsigned long hash_djb2(const char *str) {
-    unsigned long hash = 5381;
+/* Usa 32 bits fixos para que o índice do bucket seja o mesmo em qualquer
+ * plataforma (as tabelas estáticas abaixo dependem disso). */
+static uint32_t hash_djb2(const char *str) {
+    uint32_t hash = 5381;
     int c;
     while ((c = (unsigned char)*str++))
         hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
@@ -86,12 +133,13 @@ static void inicializarHash(HashTable *ht) {
 void inserirNaHash(HashTable *ht, const char *pista, const char *suspeito) {
     if (!pista || !suspeito) return;
     unsigned long h = hash_djb2(pista) % HASH_SIZE;
-    HashItem *cur = ht->buckets[h];
+    const HashItem *cur = ht->buckets[h];
     while (cur) {
         if (strcmp(cur->pista, pista) == 0) {
-            /* atualiza suspeito */
-            free(cur->suspeito);
-            cur->suspeito = strdup_local(suspeito);
+            /* atualiza suspeito (item alocado por esta função) */
+            HashItem *it = (HashItem *)cur;
+            free((void *)it->suspeito);
+            it->suspeito = strdup_local(suspeito);
             return;
         }
         cur = cur->prox;
@@ -108,10 +156,10 @@ void inserirNaHash(HashTable *ht, const char *pista, const char *suspeito) {
  * Função exigida: encontrarSuspeito()
  * Retorna NULL se não houver associação.
  */
-char *encontrarSuspeito(HashTable *ht, const char *pista) {
+const char *encontrarSuspeito(const HashTable *ht, const char *pista) {
     if (!pista) return NULL;
     unsigned long h = hash_djb2(pista) % HASH_SIZE;
-    HashItem *cur = ht->buckets[h];
+    const HashItem *cur = ht->buckets[h];
     while (cur) {
         if (strcmp(cur->pista, pista) == 0) return cur->suspeito;
         cur = cur->prox;
@@ -119,14 +167,14 @@ char *encontrarSuspeito(HashTable *ht, const char *pista) {
     return NULL;
 }
 
-/* Libera memória da tabela hash */
+/* Libera memória da tabela hash (apenas tabelas montadas com inserirNaHash) */
 static void liberarHash(HashTable *ht) {
     for (int i = 0; i < HASH_SIZE; ++i) {
-        HashItem *cur = ht->buckets[i];
+        HashItem *cur = (HashItem *)ht->buckets[i];
         while (cur) {
-            HashItem *next = cur->prox;
-            free(cur->pista);
-            free(cur->suspeito);
+            HashItem *next = (HashItem *)cur->prox;
+            free((void *)cur->pista);
+            free((void *)cur->suspeito);
             free(cur);
             cur = next;
         }
@@ -176,10 +224,10 @@ void imprimirPistasInOrder(PistaNode *root) {
 /* Conta quantas pistas na BST apontam para um suspeito dado (usando tabela hash).
  * Função auxiliar para verificação final.
  */
-int contarPistasParaSuspeito(PistaNode *root, HashTable *ht, const char *suspeito) {
+int contarPistasParaSuspeito(PistaNode *root, const HashTable *ht, const char *suspeito) {
     if (!root) return 0;
     int count = 0;
-    char *s = encontrarSuspeito(ht, root->pista);
+    const char *s = encontrarSuspeito(ht, root->pista);
     if (s && strcmp(s, suspeito) == 0) count = 1;
     return count + contarPistasParaSuspeito(root->esq, ht, suspeito)
                  + contarPistasParaSuspeito(root->dir, ht, suspeito);
@@ -206,48 +254,167 @@ Sala *criarSala(const char *nome) {
     return s;
 }
 
-/* Libera recursivamente a mansão (salas) */
+/* Libera recursivamente a mansão (apenas salas criadas com criarSala) */
 void liberarMansao(Sala *root) {
     if (!root) return;
-    liberarMansao(root->esq);
-    liberarMansao(root->dir);
-    free(root->nome);
+    liberarMansao((Sala *)root->esq);
+    liberarMansao((Sala *)root->dir);
+    free((void *)root->nome);
     free(root);
 }
 
+/* ----------- CENÁRIO EMBUTIDO (TABELAS ESTÁTICAS) --------- */
+
+/* O mapa fixo e as associações pista -> suspeito ficam em tabelas const
+ * inicializadas em tempo de compilação: a inicialização não aloca memória
+ * nem calcula hash. Outro cenário é outro conjunto destas tabelas com seu
+ * próprio Cenario.
+ */
+
+/* Mapa da mansão:
+          Entrada
+         /       \
+    Sala de      Cozinha
+    Estar
+    /   \         /   \
+Biblioteca Escritório Quarto Mestre Jardim
+               \       /
+             Closet  Porão
+*/
+enum {
+    SALA_ENTRADA, SALA_ESTAR, SALA_COZINHA, SALA_BIBLIOTECA, SALA_ESCRITORIO,
+    SALA_QUARTO, SALA_CLOSET, SALA_JARDIM, SALA_PORAO,
+    NUM_SALAS_MANSAO
+};
+
+static const Sala SALAS_MANSAO[NUM_SALAS_MANSAO] = {
+    [SALA_ENTRADA]    = {"Entrada",       &SALAS_MANSAO[SALA_ESTAR],      &SALAS_MANSAO[SALA_COZINHA]},
+    [SALA_ESTAR]      = {"Sala de Estar", &SALAS_MANSAO[SALA_BIBLIOTECA], &SALAS_MANSAO[SALA_ESCRITORIO]},
+    [SALA_COZINHA]    = {"Cozinha",       &SALAS_MANSAO[SALA_QUARTO],     &SALAS_MANSAO[SALA_JARDIM]},
+    [SALA_BIBLIOTECA] = {"Biblioteca",    NULL,                           NULL},
+    [SALA_ESCRITORIO] = {"Escritório",    NULL,                           &SALAS_MANSAO[SALA_CLOSET]},
+    [SALA_QUARTO]     = {"Quarto Mestre", &SALAS_MANSAO[SALA_PORAO],      NULL},
+    [SALA_CLOSET]     = {"Closet",        NULL,                           NULL},
+    [SALA_JARDIM]     = {"Jardim",        NULL,                           NULL},
+    [SALA_PORAO]      = {"Porão",         NULL,                           NULL},
+};
+
+/* Pistas (chave) e seus suspeitos (valor) */
+enum {
+    PISTA_PEGADA_LAMACENTA, PISTA_TACA, PISTA_CHEIRO_LIMPEZA, PISTA_LIVRO,
+    PISTA_NOTA, PISTA_CABELO, PISTA_BOTAO, PISTA_PEGADAS_MOLHADAS,
+    PISTA_FERRAMENTA,
+    NUM_PISTAS_MANSAO
+};
+
+static const HashItem PISTAS_MANSAO[NUM_PISTAS_MANSAO] = {
+    [PISTA_PEGADA_LAMACENTA] = {"pegada lamacenta",             "Mariana", NULL},
+    [PISTA_TACA]             = {"taça com manchas de vinho",    "Carlos",  NULL},
+    [PISTA_CHEIRO_LIMPEZA]   = {"cheiro de produto de limpeza", "Ricardo", NULL},
+    [PISTA_LIVRO]            = {"livro faltando",               "Ana",     NULL},
+    [PISTA_NOTA]             = {"nota rasgada",                 "Carlos",  NULL},
+    [PISTA_CABELO]           = {"fio de cabelo loiro",          "Ana",     NULL},
+    [PISTA_BOTAO]            = {"botão quebrado",               "Ricardo", NULL},
+    [PISTA_PEGADAS_MOLHADAS] = {"pegadas molhadas",             "Mariana", NULL},
+    [PISTA_FERRAMENTA]       = {"ferramenta com manchas",       "Carlos",  NULL},
+};
+
+/* Tabela hash já montada. Os índices são hash_djb2(pista) % HASH_SIZE,
+ * calculados previamente; para este conjunto de pistas não há colisões,
+ * então cada bucket usado tem exatamente um item (hash perfeito).
+ * Ao alterar as pistas, recalcule os índices (mestre --comparar roda
+ * verificarCenario(), que acusa índices errados).
+ */
+static const HashTable HASH_MANSAO = {{
+    [1]   = &PISTAS_MANSAO[PISTA_PEGADA_LAMACENTA],
+    [16]  = &PISTAS_MANSAO[PISTA_LIVRO],
+    [24]  = &PISTAS_MANSAO[PISTA_NOTA],
+    [30]  = &PISTAS_MANSAO[PISTA_BOTAO],
+    [44]  = &PISTAS_MANSAO[PISTA_TACA],
+    [45]  = &PISTAS_MANSAO[PISTA_FERRAMENTA],
+    [60]  = &PISTAS_MANSAO[PISTA_CHEIRO_LIMPEZA],
+    [86]  = &PISTAS_MANSAO[PISTA_PEGADAS_MOLHADAS],
+    [100] = &PISTAS_MANSAO[PISTA_CABELO],
+}};
+
+/* Pista encontrada em cada sala (SEM_PISTA se não houver) */
+static const int PISTA_DA_SALA_MANSAO[NUM_SALAS_MANSAO] = {
+    [SALA_ENTRADA]    = PISTA_PEGADA_LAMACENTA,
+    [SALA_ESTAR]      = PISTA_TACA,
+    [SALA_COZINHA]    = PISTA_CHEIRO_LIMPEZA,
+    [SALA_BIBLIOTECA] = PISTA_LIVRO,
+    [SALA_ESCRITORIO] = PISTA_NOTA,
+    [SALA_QUARTO]     = PISTA_CABELO,
+    [SALA_CLOSET]     = PISTA_BOTAO,
+    [SALA_JARDIM]     = PISTA_PEGADAS_MOLHADAS,
+    [SALA_PORAO]      = PISTA_FERRAMENTA,
+};
+
+static const Cenario CENARIO_MANSAO = {
+    "Mansão",
+    SALAS_MANSAO, NUM_SALAS_MANSAO,
+    PISTA_DA_SALA_MANSAO,
+    PISTAS_MANSAO, NUM_PISTAS_MANSAO,
+    &HASH_MANSAO,
+};
+
+/* Confere um cenário: limites, filhos dentro do vetor de salas, índices de
+ * pista válidos e cada pista no bucket indicado por hash_djb2(). Usada por
+ * --comparar, não na partida (que não calcula hash ao iniciar).
+ * Imprime o primeiro erro e retorna 1; retorna 0 se estiver ok.
+ */
+static int verificarCenario(const Cenario *cen) {
+    if (cen->nSalas < 1 || cen->nSalas > MAX_ITENS_CENARIO
+        || cen->nPistas < 0 || cen->nPistas > MAX_ITENS_CENARIO) {
+        fprintf(stderr, "Cenário '%s': número de salas/pistas inválido.\n", cen->titulo);
+        return 1;
+    }
+    for (int i = 0; i < cen->nSalas; ++i) {
+        const Sala *s = &cen->salas[i];
+        int p = cen->pistaDaSala[i];
+        if ((s->esq && (s->esq < cen->salas || s->esq >= cen->salas + cen->nSalas))
+            || (s->dir && (s->dir < cen->salas || s->dir >= cen->salas + cen->nSalas))
+            || (p != SEM_PISTA && (p < 0 || p >= cen->nPistas))) {
+            fprintf(stderr, "Cenário '%s': sala '%s' inválida.\n", cen->titulo, s->nome);
+            return 1;
+        }
+    }
+    for (int p = 0; p < cen->nPistas; ++p) {
+        const HashItem *cur = cen->hash->buckets[hash_djb2(cen->pistas[p].pista) % HASH_SIZE];
+        while (cur && cur != &cen->pistas[p]) cur = cur->prox;
+        if (!cur) {
+            fprintf(stderr, "Cenário '%s': pista '%s' fora do bucket esperado.\n",
+                    cen->titulo, cen->pistas[p].pista);
+            return 1;
+        }
+    }
+    return 0;
+}
+
 /* ----------- LÓGICA QUE ASSOCIA SALAS ÀS PISTAS --------- */
 
-/* Retorna a pista associada a um nome de sala.
- * "Pista estática definida por lógica no código", conforme requisito.
+/* Retorna a pista associada a uma sala do cenário (`sala` aponta para
+ * cen->salas). "Pista estática definida por lógica no código", conforme
+ * requisito: consulta direta por índice nas tabelas do cenário.
  * Retorna NULL se não houver pista nessa sala.
  */
-const char *pistaParaSala(const char *nomeSala) {
-    if (strcmp(nomeSala, "Entrada") == 0) {
-        return "pegada lamacenta";
-    } else if (strcmp(nomeSala, "Sala de Estar") == 0) {
-        return "taça com manchas de vinho";
-    } else if (strcmp(nomeSala, "Cozinha") == 0) {
-        return "cheiro de produto de limpeza";
-    } else if (strcmp(nomeSala, "Biblioteca") == 0) {
-        return "livro faltando";
-    } else if (strcmp(nomeSala, "Escritório") == 0) {
-        return "nota rasgada";
-    } else if (strcmp(nomeSala, "Quarto Mestre") == 0) {
-        return "fio de cabelo loiro";
-    } else if (strcmp(nomeSala, "Closet") == 0) {
-        return "botão quebrado";
-    } else if (strcmp(nomeSala, "Jardim") == 0) {
-        return "pegadas molhadas";
-    } else if (strcmp(nomeSala, "Porão") == 0) {
-        return "ferramenta com manchas";
-    } else {
-        return NULL;
-    }
+const char *pistaParaSala(const Cenario *cen, const Sala *sala) {
+    int p = cen->pistaDaSala[sala - cen->salas];
+    return p == SEM_PISTA ? NULL : cen->pistas[p].pista;
 }
 
 /* ----------- EXPLORAÇÃO INTERATIVA DAS SALAS --------- */
 
-/* Explora a mansão começando de `inicio`. Em cada sala:
+/* Retorna a sala alcançada a partir de `atual` com o comando `c`
+ * ('e' ou 'd', sem diferenciar maiúsculas), ou NULL se não houver caminho.
+ */
+static const Sala *proximaSala(const Sala *atual, char c) {
+    if ((c == 'e' || c == 'E') && atual->esq) return atual->esq;
+    if ((c == 'd' || c == 'D') && atual->dir) return atual->dir;
+    return NULL;
+}
+
+/* Explora a mansão do cenário começando pela entrada. Em cada sala:
  * - Exibe nome da sala.
  * - Se existir pista associada, exibe e coleta (insere na BST) e garante associação na hash já definida.
  * - Permite escolher: esquerda (e), direita (d), sair (s).
@@ -255,20 +422,21 @@ const char *pistaParaSala(const char *nomeSala) {
  * Função exigida: explorarSalas()
  *
  * Observação: A exploração é interativa; a função retorna quando o jogador decide sair.
+ * Se `sessao` não for NULL, os movimentos válidos ('e'/'d') são anotados nela.
  */
-void explorarSalas(Sala *inicio, PistaNode **pistasColetadas, HashTable *ht) {
-    if (!inicio) {
+void explorarSalas(const Cenario *cen, PistaNode **pistasColetadas, Sessao *sessao) {
+    if (!cen || cen->nSalas < 1) {
         printf("Nenhuma sala para explorar.\n");
         return;
     }
 
-    Sala *atual = inicio;
+    const Sala *atual = &cen->salas[0];
     char escolha[32];
 
     printf("Iniciando exploração da mansão. Comandos: 'e'=esquerda, 'd'=direita, 's'=sair\n");
     while (1) {
         printf("\nVocê está na sala: %s\n", atual->nome);
-        const char *p = pistaParaSala(atual->nome);
+        const char *p = pistaParaSala(cen, atual);
         if (p) {
             printf("Encontrou uma pista: %s\n", p);
             /* insere na BST (evita duplicatas) */
@@ -295,13 +463,16 @@ void explorarSalas(Sala *inicio, PistaNode **pistasColetadas, HashTable *ht) {
                 break;
             }
         }
+        const Sala *prox;
         if (c == 's' || c == 'S') {
             printf("Você encerrou a exploração.\n");
             break;
-        } else if ((c == 'e' || c == 'E') && atual->esq) {
-            atual = atual->esq;
-        } else if ((c == 'd' || c == 'D') && atual->dir) {
-            atual = atual->dir;
+        } else if ((prox = proximaSala(atual, c)) != NULL) {
+            atual = prox;
+            if (sessao && sessao->nMovimentos < sizeof(sessao->movimentos) - 1) {
+                sessao->movimentos[sessao->nMovimentos++] = (char)tolower((unsigned char)c);
+                sessao->movimentos[sessao->nMovimentos] = '\0';
+            }
         } else {
             printf("Opção inválida ou direção inexistente. Tente novamente.\n");
         }
@@ -316,8 +487,9 @@ void explorarSalas(Sala *inicio, PistaNode **pistasColetadas, HashTable *ht) {
  * - Verifica se ao menos duas pistas apontam para esse suspeito
  *
  * Função exigida: verificarSuspeitoFinal()
+ * Se `sessao` não for NULL, o nome acusado é anotado nela.
  */
-void verificarSuspeitoFinal(PistaNode *pistasColetadas, HashTable *ht) {
+void verificarSuspeitoFinal(PistaNode *pistasColetadas, const HashTable *ht, Sessao *sessao) {
     printf("\n----- FASE DE JULGAMENTO -----\n");
     if (!pistasColetadas) {
         printf("Você não coletou nenhuma pista. Não há como acusar com base em evidências.\n");
@@ -343,6 +515,8 @@ void verificarSuspeitoFinal(PistaNode *pistasColetadas, HashTable *ht) {
         return;
     }
 
+    if (sessao) snprintf(sessao->acusado, sizeof(sessao->acusado), "%s", start);
+
     /* contar pistas que apontam para o acusado */
     int contagem = contarPistasParaSuspeito(pistasColetadas, ht, start);
     printf("\nPistas que apontam para '%s': %d\n", start, contagem);
@@ -353,25 +527,325 @@ void verificarSuspeitoFinal(PistaNode *pistasColetadas, HashTable *ht) {
     }
 }
 
-/* ----------- FUNÇÃO MAIN - MONTA MAPA FIXO E ASSOCIAÇÕES ---------- */
+/* ----------- ANÁLISE DE REGISTROS DE SESSÕES ------------ */
+
+/* Cada linha do registro é uma sessão: "movimentos;acusado", por exemplo
+ * "edd;Carlos". O arquivo é dividido em fatias processadas por threads;
+ * cada thread lê sua fatia em blocos de tamanho fixo, então a memória usada
+ * não depende do tamanho do registro.
+ */
+
+/* Contadores agregados (somados entre as fatias no final) */
+typedef struct {
+    unsigned long long sessoes;
+    unsigned long long acusacoes;
+    unsigned long long vitorias;
+    unsigned long long visitas[MAX_ITENS_CENARIO];
+    unsigned long long descobertas[MAX_ITENS_CENARIO];
+} Estatisticas;
+
+/* Estado de uma sessão sendo lida. Como a exploração só desce na árvore,
+ * cada sala é visitada no máximo uma vez, e um bitmask basta.
+ */
+typedef struct {
+    const Cenario *cen;
+    const Sala *atual;
+    unsigned salas;          /* bit i: cen->salas[i] visitada */
+    int temConteudo;         /* linha não vazia */
+    int lendoAcusado;        /* já passou do ';' */
+    char acusado[128];
+    size_t tamAcusado;
+} EstadoSessao;
+
+/* Fatia do arquivo [inicio, fim) atribuída a uma thread */
+typedef struct {
+    const Cenario *cen;
+    const char *arquivo;
+    long long inicio;
+    long long fim;
+    Estatisticas est;
+    int erro;
+} Fatia;
+
+static void iniciarSessao(EstadoSessao *s, const Cenario *cen) {
+    s->cen = cen;
+    s->atual = &cen->salas[0];
+    s->salas = 1u;
+    s->temConteudo = 0;
+    s->lendoAcusado = 0;
+    s->tamAcusado = 0;
+}
+
+/* Aplica um caractere da linha, seguindo as mesmas regras de explorarSalas() */
+static void processarCaractere(EstadoSessao *s, char c) {
+    if (c == '\r') return;
+    s->temConteudo = 1;
+    if (s->lendoAcusado) {
+        if (s->tamAcusado < sizeof(s->acusado) - 1) s->acusado[s->tamAcusado++] = c;
+        return;
+    }
+    if (c == ';') {
+        s->lendoAcusado = 1;
+        return;
+    }
+    const Sala *prox = proximaSala(s->atual, c);
+    if (prox) {
+        s->atual = prox;
+        s->salas |= 1u << (unsigned)(prox - s->cen->salas);
+    }
+}
+
+/* Bitmask das pistas encontradas nas salas visitadas */
+static unsigned pistasDasSalas(const Cenario *cen, unsigned salas) {
+    unsigned pistas = 0;
+    for (int i = 0; i < cen->nSalas; ++i) {
+        if ((salas & (1u << i)) && cen->pistaDaSala[i] != SEM_PISTA)
+            pistas |= 1u << cen->pistaDaSala[i];
+    }
+    return pistas;
+}
+
+/* Equivalente a contarPistasParaSuspeito() para um bitmask de pistas */
+static int contarPistasMascara(const Cenario *cen, unsigned pistas, const char *suspeito) {
+    int contagem = 0;
+    for (int p = 0; p < cen->nPistas; ++p) {
+        if (!(pistas & (1u << p))) continue;
+        const char *s = encontrarSuspeito(cen->hash, cen->pistas[p].pista);
+        if (s && strcmp(s, suspeito) == 0) contagem++;
+    }
+    return contagem;
+}
+
+/* Soma a sessão lida às estatísticas. A vitória usa o critério de
+ * verificarSuspeitoFinal(): ao menos duas pistas apontando para o acusado.
+ */
+static void finalizarSessao(EstadoSessao *s, Estatisticas *est) {
+    if (!s->temConteudo) return;
+    est->sessoes++;
+
+    for (int i = 0; i < s->cen->nSalas; ++i)
+        if (s->salas & (1u << i)) est->visitas[i]++;
+    unsigned pistas = pistasDasSalas(s->cen, s->salas);
+    for (int p = 0; p < s->cen->nPistas; ++p)
+        if (pistas & (1u << p)) est->descobertas[p]++;
+
+    s->acusado[s->tamAcusado] = '\0';
+    const char *acusado = s->acusado;
+    while (*acusado && isspace((unsigned char)*acusado)) acusado++;
+    if (*acusado == '\0') return;
+
+    est->acusacoes++;
+    if (contarPistasMascara(s->cen, pistas, acusado) >= 2) est->vitorias++;
+}
+
+/* Processa as linhas que começam dentro da fatia. A linha que cruza o
+ * início pertence à fatia anterior e é descartada aqui.
+ */
+static void *processarFatia(void *arg) {
+    Fatia *f = arg;
+    FILE *fp = fopen(f->arquivo, "rb");
+    char *buf = malloc(TAM_BLOCO_LEITURA);
+    if (!fp || !buf) {
+        f->erro = 1;
+        if (fp) fclose(fp);
+        free(buf);
+        return NULL;
+    }
+
+    long long pos = f->inicio > 0 ? f->inicio - 1 : 0;
+    if (fseeko(fp, (off_t)pos, SEEK_SET) != 0) f->erro = 1;
+
+    EstadoSessao s;
+    int pulando = f->inicio > 0;     /* descartando o fim da linha anterior */
+    int inicioLinha = !pulando;
+    int terminou = f->erro;
+    size_t n;
+    while (!terminou && (n = fread(buf, 1, TAM_BLOCO_LEITURA, fp)) > 0) {
+        for (size_t i = 0; i < n; ++i, ++pos) {
+            char c = buf[i];
+            if (pulando) {
+                if (c == '\n') {
+                    pulando = 0;
+                    inicioLinha = 1;
+                }
+                continue;
+            }
+            if (inicioLinha) {
+                if (pos >= f->fim) {
+                    terminou = 1;
+                    break;
+                }
+                iniciarSessao(&s, f->cen);
+                inicioLinha = 0;
+            }
+            if (c == '\n') {
+                finalizarSessao(&s, &f->est);
+                inicioLinha = 1;
+            } else {
+                processarCaractere(&s, c);
+            }
+        }
+    }
+    /* última linha sem '\n' */
+    if (!pulando && !inicioLinha) finalizarSessao(&s, &f->est);
+    if (ferror(fp)) f->erro = 1;
+
+    free(buf);
+    fclose(fp);
+    return NULL;
+}
+
+static double percentual(unsigned long long parte, unsigned long long total) {
+    return total ? 100.0 * (double)parte / (double)total : 0.0;
+}
+
+/* Lê o registro `arquivo` com `nThreads` threads e imprime visitas por sala,
+ * taxa de descoberta de cada pista e taxa de vitória das acusações.
+ * Retorna 0 em caso de sucesso.
+ */
+int analisarRegistro(const Cenario *cen, const char *arquivo, int nThreads) {
+    FILE *fp = fopen(arquivo, "rb");
+    if (!fp) {
+        printf("Não foi possível abrir o registro '%s'.\n", arquivo);
+        return 1;
+    }
+    long long tamanho = fseeko(fp, 0, SEEK_END) == 0 ? (long long)ftello(fp) : -1;
+    fclose(fp);
+    if (tamanho < 0) {
+        printf("Não foi possível ler o tamanho de '%s'.\n", arquivo);
+        return 1;
+    }
+
+    if (nThreads < 1) nThreads = 1;
+    if (nThreads > MAX_THREADS) nThreads = MAX_THREADS;
+    /* não vale a pena dividir arquivos menores que um bloco */
+    if (tamanho < (long long)nThreads * TAM_BLOCO_LEITURA) {
+        nThreads = (int)(tamanho / TAM_BLOCO_LEITURA) + 1;
+    }
+
+    Fatia fatias[MAX_THREADS];
+    pthread_t threads[MAX_THREADS];
+    for (int i = 0; i < nThreads; ++i) {
+        memset(&fatias[i], 0, sizeof(Fatia));
+        fatias[i].cen = cen;
+        fatias[i].arquivo = arquivo;
+        fatias[i].inicio = tamanho * i / nThreads;
+        fatias[i].fim = tamanho * (i + 1) / nThreads;
+        if (pthread_create(&threads[i], NULL, processarFatia, &fatias[i]) != 0) {
+            /* sem thread disponível: processa na thread atual */
+            processarFatia(&fatias[i]);
+            threads[i] = pthread_self();
+        }
+    }
+
+    Estatisticas total;
+    memset(&total, 0, sizeof(total));
+    int erro = 0;
+    for (int i = 0; i < nThreads; ++i) {
+        if (!pthread_equal(threads[i], pthread_self())) pthread_join(threads[i], NULL);
+        Estatisticas *e = &fatias[i].est;
+        erro |= fatias[i].erro;
+        total.sessoes += e->sessoes;
+        total.acusacoes += e->acusacoes;
+        total.vitorias += e->vitorias;
+        for (int j = 0; j < cen->nSalas; ++j) total.visitas[j] += e->visitas[j];
+        for (int j = 0; j < cen->nPistas; ++j) total.descobertas[j] += e->descobertas[j];
+    }
+    if (erro) {
+        printf("Erro ao ler o registro '%s'.\n", arquivo);
+        return 1;
+    }
+
+    printf("Sessões analisadas: %llu (%d thread(s))\n", total.sessoes, nThreads);
+    printf("\nVisitas por sala:\n");
+    for (int i = 0; i < cen->nSalas; ++i) {
+        printf(" - %-16s %12llu (%5.1f%% das sessões)\n", cen->salas[i].nome,
+               total.visitas[i], percentual(total.visitas[i], total.sessoes));
+    }
+    printf("\nTaxa de descoberta das pistas:\n");
+    for (int p = 0; p < cen->nPistas; ++p) {
+        printf(" - %-30s %5.1f%%\n", cen->pistas[p].pista,
+               percentual(total.descobertas[p], total.sessoes));
+    }
+    printf("\nAcusações: %llu, vitórias: %llu (%.1f%%)\n", total.acusacoes,
+           total.vitorias, percentual(total.vitorias, total.acusacoes));
+    return 0;
+}
+
+/* ----------- COMPARAÇÃO COM AS IMPLEMENTAÇÕES DE REFERÊNCIA ------------ */
+
+/* Executa as mesmas sessões aleatórias em duas implementações e confere
+ * que os resultados são idênticos:
+ * - referência: mansão montada com criarSala(), hash com inserirNaHash(),
+ *   pistas das salas pela cadeia if/else original, coletadas na BST com
+ *   inserirPista() e contadas com contarPistasParaSuspeito();
+ * - otimizada: tabelas de um Cenario, bitmasks de salas/pistas (usada por
+ *   --analisar) e a tabela hash do cenário.
+ * Roda em duas fases: a mansão embutida contra a montagem original do jogo
+ * (copiada abaixo, independente das tabelas), e cenários gerados ao acaso,
+ * dos quais saem tanto as estruturas de referência quanto as tabelas.
+ * Compara pistas coletadas, contagem e veredito de cada sessão, e também
+ * encontrarSuspeito() nas duas tabelas para chaves geradas. O tempo de cada
+ * implementação é medido separadamente, lote a lote.
+ */
+
+/* Pista de uma sala na implementação de referência */
+typedef const char *(*PistaReferencia)(const void *dados, const char *nomeSala);
+
+/* Tempos e contadores de uma fase da comparação */
+typedef struct {
+    unsigned long long sessoes;
+    unsigned long long consultas;
+    unsigned long long divergencias;
+    clock_t tempoRef, tempoOpt;
+    clock_t tempoHashRef, tempoHashOpt;
+} ResultadoComparacao;
+
+/* Cenário gerado: descrição por índices, da qual são montadas as duas
+ * implementações. esq/dir valem -1 quando não há filho.
+ */
+typedef struct {
+    int nSalas;
+    int nPistas;
+    char nomes[MAX_ITENS_CENARIO][16];
+    int esq[MAX_ITENS_CENARIO];
+    int dir[MAX_ITENS_CENARIO];
+    int pista[MAX_ITENS_CENARIO];
+    char pistas[MAX_ITENS_CENARIO][32];
+    const char *suspeito[MAX_ITENS_CENARIO];
+} DescricaoCenario;
+
+/* Tabelas otimizadas montadas a partir de uma DescricaoCenario */
+typedef struct {
+    Sala salas[MAX_ITENS_CENARIO];
+    HashItem pistas[MAX_ITENS_CENARIO];
+    int pistaDaSala[MAX_ITENS_CENARIO];
+    HashTable hash;
+    Cenario cen;
+} TabelasGeradas;
+
+static const char *const ACUSADOS_COMPARACAO[] = {
+    "Mariana", "Carlos", "Ricardo", "Ana", "Bruno", "carlos", "Zé", "Ana ", ""
+};
+#define NUM_ACUSADOS_COMPARACAO \
+    ((int)(sizeof(ACUSADOS_COMPARACAO) / sizeof(ACUSADOS_COMPARACAO[0])))
+#define NUM_SUSPEITOS_GERADOS 5   /* primeiros nomes de ACUSADOS_COMPARACAO */
+
+/* Gerador xorshift32: mesma sequência em qualquer plataforma */
+static uint32_t proximoAleatorio(uint32_t *estado) {
+    uint32_t x = *estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *estado = x;
+}
+
+/* Montagem original do jogo (antes do cenário embutido): mesma sequência de
+ * criarSala(), ligações e inserirNaHash(). Não usa as tabelas estáticas.
+ */
+static void montarCenarioReferencia(Sala **entradaMansao, HashTable *ht) {
+    inicializarHash(ht);
 
-int main(void) {
-    /* Inicializa estrutura de pistas e hash */
-    PistaNode *pistasColetadas = NULL;
-    HashTable ht;
-    inicializarHash(&ht);
-
-    /* Monta a mansão (árvore binária de salas) - fixo, manual */
-    /*
-              Entrada
-             /       \
-        Sala de      Cozinha
-        Estar
-        /   \         /   \
-    Biblioteca Escritório Quarto Mestre Jardim
-                       \
-                       Closet
-    */
     Sala *entrada = criarSala("Entrada");
     Sala *salaEstar = criarSala("Sala de Estar");
     Sala *cozinha = criarSala("Cozinha");
@@ -389,40 +863,416 @@ int main(void) {
     salaEstar->dir = escritorio;
     cozinha->esq = quarto;
     cozinha->dir = jardim;
-    escritorio->dir = closet; /* escritório tem um caminho ao closet */
-    /* adicionar porão ligado ao quarto (como exemplo de nó adicional) */
+    escritorio->dir = closet;
     quarto->esq = porao;
 
-    /* Define associações pista -> suspeito na hash (pré-definidas) */
-    /* Estas ligações devem refletir a "história". Exemplos: */
-    inserirNaHash(&ht, "pegada lamacenta", "Mariana");
-    inserirNaHash(&ht, "pega das molhadas", "Mariana"); /* cuidado: typo intencional evitado abaixo */
-    inserirNaHash(&ht, "pegadas molhadas", "Mariana");
-    inserirNaHash(&ht, "taça com manchas de vinho", "Carlos");
-    inserirNaHash(&ht, "cheiro de produto de limpeza", "Ricardo");
-    inserirNaHash(&ht, "livro faltando", "Ana");
-    inserirNaHash(&ht, "nota rasgada", "Carlos");
-    inserirNaHash(&ht, "fio de cabelo loiro", "Ana");
-    inserirNaHash(&ht, "botão quebrado", "Ricardo");
-    inserirNaHash(&ht, "ferramenta com manchas", "Carlos");
-
-    /* Observação: todas as pistas definidas em pistaParaSala devem ter uma entrada na hash */
-    /* Caso alguma pista não esteja na tabela, encontrarSuspeito() retornará NULL. */
+    inserirNaHash(ht, "pegada lamacenta", "Mariana");
+    inserirNaHash(ht, "pega das molhadas", "Mariana");
+    inserirNaHash(ht, "pegadas molhadas", "Mariana");
+    inserirNaHash(ht, "taça com manchas de vinho", "Carlos");
+    inserirNaHash(ht, "cheiro de produto de limpeza", "Ricardo");
+    inserirNaHash(ht, "livro faltando", "Ana");
+    inserirNaHash(ht, "nota rasgada", "Carlos");
+    inserirNaHash(ht, "fio de cabelo loiro", "Ana");
+    inserirNaHash(ht, "botão quebrado", "Ricardo");
+    inserirNaHash(ht, "ferramenta com manchas", "Carlos");
+
+    *entradaMansao = entrada;
+}
+
+/* Cópia da pistaParaSala() original (cadeia if/else) */
+static const char *pistaParaSalaReferencia(const void *dados, const char *nomeSala) {
+    (void)dados;
+    if (strcmp(nomeSala, "Entrada") == 0) {
+        return "pegada lamacenta";
+    } else if (strcmp(nomeSala, "Sala de Estar") == 0) {
+        return "taça com manchas de vinho";
+    } else if (strcmp(nomeSala, "Cozinha") == 0) {
+        return "cheiro de produto de limpeza";
+    } else if (strcmp(nomeSala, "Biblioteca") == 0) {
+        return "livro faltando";
+    } else if (strcmp(nomeSala, "Escritório") == 0) {
+        return "nota rasgada";
+    } else if (strcmp(nomeSala, "Quarto Mestre") == 0) {
+        return "fio de cabelo loiro";
+    } else if (strcmp(nomeSala, "Closet") == 0) {
+        return "botão quebrado";
+    } else if (strcmp(nomeSala, "Jardim") == 0) {
+        return "pegadas molhadas";
+    } else if (strcmp(nomeSala, "Porão") == 0) {
+        return "ferramenta com manchas";
+    } else {
+        return NULL;
+    }
+}
+
+/* Gera um cenário: árvore aleatória de 1..MAX_ITENS_CENARIO salas, pistas
+ * com textos aleatórios (podem colidir na hash) e suspeitos sorteados.
+ * Cerca de 1/4 das salas fica sem pista; várias salas podem ter a mesma.
+ */
+static void gerarDescricao(DescricaoCenario *d, uint32_t *rng) {
+    d->nSalas = 1 + (int)(proximoAleatorio(rng) % MAX_ITENS_CENARIO);
+    d->nPistas = 1 + (int)(proximoAleatorio(rng) % MAX_ITENS_CENARIO);
+
+    for (int p = 0; p < d->nPistas; ++p) {
+        snprintf(d->pistas[p], sizeof(d->pistas[p]), "pista %d %08lx", p,
+                 (unsigned long)proximoAleatorio(rng));
+        d->suspeito[p] = ACUSADOS_COMPARACAO[proximoAleatorio(rng) % NUM_SUSPEITOS_GERADOS];
+    }
+    for (int i = 0; i < d->nSalas; ++i) {
+        snprintf(d->nomes[i], sizeof(d->nomes[i]), "Sala %d", i);
+        d->esq[i] = d->dir[i] = -1;
+        d->pista[i] = proximoAleatorio(rng) % 4 == 0
+                      ? SEM_PISTA : (int)(proximoAleatorio(rng) % (uint32_t)d->nPistas);
+    }
+    /* cada sala nova vira filha de uma sala anterior com lugar livre */
+    for (int i = 1; i < d->nSalas; ++i) {
+        int pai = (int)(proximoAleatorio(rng) % (uint32_t)i);
+        int lado = (int)(proximoAleatorio(rng) % 2);
+        while (d->esq[pai] >= 0 && d->dir[pai] >= 0) pai = (pai + 1) % i;
+        if ((lado == 0 && d->esq[pai] < 0) || d->dir[pai] >= 0) d->esq[pai] = i;
+        else d->dir[pai] = i;
+    }
+}
+
+/* Implementação de referência do cenário gerado */
+static Sala *montarReferenciaGerada(const DescricaoCenario *d, HashTable *ht) {
+    Sala *salas[MAX_ITENS_CENARIO];
+    for (int i = 0; i < d->nSalas; ++i) salas[i] = criarSala(d->nomes[i]);
+    for (int i = 0; i < d->nSalas; ++i) {
+        if (d->esq[i] >= 0) salas[i]->esq = salas[d->esq[i]];
+        if (d->dir[i] >= 0) salas[i]->dir = salas[d->dir[i]];
+    }
+    inicializarHash(ht);
+    for (int p = 0; p < d->nPistas; ++p) inserirNaHash(ht, d->pistas[p], d->suspeito[p]);
+    return salas[0];
+}
+
+/* Pista de uma sala do cenário gerado, procurada pelo nome */
+static const char *pistaDescricao(const void *dados, const char *nomeSala) {
+    const DescricaoCenario *d = dados;
+    for (int i = 0; i < d->nSalas; ++i) {
+        if (strcmp(nomeSala, d->nomes[i]) == 0)
+            return d->pista[i] == SEM_PISTA ? NULL : d->pistas[d->pista[i]];
+    }
+    return NULL;
+}
+
+/* Tabelas otimizadas do cenário gerado, montadas como um gerador de
+ * cenários embutidos faria: vetores indexados e buckets pré-calculados.
+ */
+static void montarTabelasGeradas(const DescricaoCenario *d, TabelasGeradas *t) {
+    for (int i = 0; i < d->nSalas; ++i) {
+        t->salas[i].nome = d->nomes[i];
+        t->salas[i].esq = d->esq[i] >= 0 ? &t->salas[d->esq[i]] : NULL;
+        t->salas[i].dir = d->dir[i] >= 0 ? &t->salas[d->dir[i]] : NULL;
+        t->pistaDaSala[i] = d->pista[i];
+    }
+    memset(&t->hash, 0, sizeof(t->hash));
+    for (int p = 0; p < d->nPistas; ++p) {
+        uint32_t h = hash_djb2(d->pistas[p]) % HASH_SIZE;
+        t->pistas[p].pista = d->pistas[p];
+        t->pistas[p].suspeito = d->suspeito[p];
+        t->pistas[p].prox = t->hash.buckets[h];
+        t->hash.buckets[h] = &t->pistas[p];
+    }
+    t->cen.titulo = "gerado";
+    t->cen.salas = t->salas;
+    t->cen.nSalas = d->nSalas;
+    t->cen.pistaDaSala = t->pistaDaSala;
+    t->cen.pistas = t->pistas;
+    t->cen.nPistas = d->nPistas;
+    t->cen.hash = &t->hash;
+}
+
+/* Uma sessão pela lógica de explorarSalas()/verificarSuspeitoFinal(),
+ * sem interação. O movimento é a cópia do desvio e/d original, sem usar
+ * proximaSala(). Retorna quantas pistas apontam para `acusado`.
+ */
+static int sessaoReferencia(PistaReferencia pistaRef, const void *dados, const Sala *entrada,
+                            const HashTable *ht, const char *movimentos, const char *acusado,
+                            PistaNode **pistas) {
+    const Sala *atual = entrada;
+    const char *p = pistaRef(dados, atual->nome);
+    if (p) inserirPista(pistas, p);
+    for (; *movimentos; ++movimentos) {
+        char c = *movimentos;
+        if ((c == 'e' || c == 'E') && atual->esq) {
+            atual = atual->esq;
+        } else if ((c == 'd' || c == 'D') && atual->dir) {
+            atual = atual->dir;
+        } else {
+            continue;
+        }
+        p = pistaRef(dados, atual->nome);
+        if (p) inserirPista(pistas, p);
+    }
+    return contarPistasParaSuspeito(*pistas, ht, acusado);
+}
+
+/* Mesma sessão pelas estruturas otimizadas; devolve o bitmask de pistas */
+static int sessaoOtimizada(const Cenario *cen, const char *movimentos, const char *acusado,
+                           uint32_t *pistas) {
+    EstadoSessao s;
+    iniciarSessao(&s, cen);
+    for (; *movimentos; ++movimentos) processarCaractere(&s, *movimentos);
+    *pistas = pistasDasSalas(cen, s.salas);
+    return contarPistasMascara(cen, *pistas, acusado);
+}
+
+/* Acrescenta a `mascara` os índices (no cenário) das pistas da BST.
+ * Retorna 1 se houver pista desconhecida ou repetida; 0 caso contrário.
+ */
+static int mascaraDaArvore(const Cenario *cen, PistaNode *root, uint32_t *mascara) {
+    if (!root) return 0;
+    if (mascaraDaArvore(cen, root->esq, mascara) != 0
+        || mascaraDaArvore(cen, root->dir, mascara) != 0) return 1;
+    for (int p = 0; p < cen->nPistas; ++p) {
+        if (strcmp(root->pista, cen->pistas[p].pista) == 0) {
+            uint32_t bit = (uint32_t)1 << p;
+            if (*mascara & bit) return 1;
+            *mascara |= bit;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Roda `lote` sessões e `lote` consultas geradas nas duas implementações
+ * de um cenário, acumulando tempos e divergências em `r`.
+ */
+static void compararLote(const Cenario *cen, PistaReferencia pistaRef, const void *dados,
+                         const Sala *entrada, const HashTable *ht, int lote,
+                         uint32_t *rng, ResultadoComparacao *r) {
+    static const char COMANDOS[] = "eEdDeEdDx ";
+    static char movimentos[LOTE_COMPARACAO][MAX_MOVIMENTOS + 1];
+    static const char *acusados[LOTE_COMPARACAO];
+    static PistaNode *arvores[LOTE_COMPARACAO];
+    static int contagemRef[LOTE_COMPARACAO], contagemOpt[LOTE_COMPARACAO];
+    static uint32_t pistasOpt[LOTE_COMPARACAO];
+    static char chaves[LOTE_COMPARACAO][64];
+    static const char *resRef[LOTE_COMPARACAO], *resOpt[LOTE_COMPARACAO];
+
+    for (int i = 0; i < lote; ++i) {
+        int n = (int)(proximoAleatorio(rng) % (MAX_MOVIMENTOS + 1));
+        for (int j = 0; j < n; ++j)
+            movimentos[i][j] = COMANDOS[proximoAleatorio(rng) % (sizeof(COMANDOS) - 1)];
+        movimentos[i][n] = '\0';
+        acusados[i] = ACUSADOS_COMPARACAO[proximoAleatorio(rng) % NUM_ACUSADOS_COMPARACAO];
+        arvores[i] = NULL;
+    }
+
+    clock_t t0 = clock();
+    for (int i = 0; i < lote; ++i)
+        contagemRef[i] = sessaoReferencia(pistaRef, dados, entrada, ht, movimentos[i],
+                                          acusados[i], &arvores[i]);
+    clock_t t1 = clock();
+    for (int i = 0; i < lote; ++i)
+        contagemOpt[i] = sessaoOtimizada(cen, movimentos[i], acusados[i], &pistasOpt[i]);
+    clock_t t2 = clock();
+    r->tempoRef += t1 - t0;
+    r->tempoOpt += t2 - t1;
+
+    for (int i = 0; i < lote; ++i) {
+        uint32_t pistasRef = 0;
+        int pistaInvalida = mascaraDaArvore(cen, arvores[i], &pistasRef);
+        if (pistaInvalida || pistasRef != pistasOpt[i] || contagemRef[i] != contagemOpt[i]
+            || (contagemRef[i] >= 2) != (contagemOpt[i] >= 2)) {
+            if (++r->divergencias <= 10) {
+                printf("Divergência (%s): movimentos '%s', acusado '%s': "
+                       "pistas 0x%08lx%s x 0x%08lx, contagem %d x %d\n", cen->titulo,
+                       movimentos[i], acusados[i], (unsigned long)pistasRef,
+                       pistaInvalida ? " (pista inválida)" : "",
+                       (unsigned long)pistasOpt[i], contagemRef[i], contagemOpt[i]);
+            }
+        }
+        liberarPistas(arvores[i]);
+    }
+    r->sessoes += lote;
+
+    /* encontrarSuspeito() nas duas tabelas: pistas do cenário e mutações */
+    for (int i = 0; i < lote; ++i) {
+        const char *base = cen->pistas[proximoAleatorio(rng) % (uint32_t)cen->nPistas].pista;
+        snprintf(chaves[i], sizeof(chaves[i]), "%s", base);
+        if (proximoAleatorio(rng) % 2) {
+            size_t n = strlen(chaves[i]);
+            chaves[i][proximoAleatorio(rng) % n] = (char)('a' + proximoAleatorio(rng) % 26);
+        }
+    }
+    t0 = clock();
+    for (int i = 0; i < lote; ++i) resRef[i] = encontrarSuspeito(ht, chaves[i]);
+    t1 = clock();
+    for (int i = 0; i < lote; ++i) resOpt[i] = encontrarSuspeito(cen->hash, chaves[i]);
+    t2 = clock();
+    r->tempoHashRef += t1 - t0;
+    r->tempoHashOpt += t2 - t1;
+
+    for (int i = 0; i < lote; ++i) {
+        int iguais = (!resRef[i] && !resOpt[i])
+                     || (resRef[i] && resOpt[i] && strcmp(resRef[i], resOpt[i]) == 0);
+        if (!iguais && ++r->divergencias <= 10) {
+            printf("Divergência (%s): encontrarSuspeito('%s'): '%s' x '%s'\n", cen->titulo,
+                   chaves[i], resRef[i] ? resRef[i] : "(nenhum)",
+                   resOpt[i] ? resOpt[i] : "(nenhum)");
+        }
+    }
+    r->consultas += lote;
+}
+
+static double porSegundo(unsigned long long n, clock_t ticks) {
+    return ticks > 0 ? (double)n * CLOCKS_PER_SEC / (double)ticks : 0.0;
+}
+
+static void imprimirComparacao(const char *fase, const ResultadoComparacao *r) {
+    printf("%s: %llu sessões, %llu divergência(s)\n", fase, r->sessoes, r->divergencias);
+    printf("  Sessões/s   - referência: %12.0f  otimizada: %12.0f\n",
+           porSegundo(r->sessoes, r->tempoRef), porSegundo(r->sessoes, r->tempoOpt));
+    printf("  Consultas/s - referência: %12.0f  otimizada: %12.0f\n",
+           porSegundo(r->consultas, r->tempoHashRef), porSegundo(r->consultas, r->tempoHashOpt));
+}
+
+/* Roda `nSessoes` sessões na mansão embutida e outras `nSessoes` espalhadas
+ * por cenários gerados (SESSOES_POR_CENARIO em cada), a partir de `semente`.
+ * Retorna 0 se as implementações concordarem em tudo.
+ */
+int compararImplementacoes(unsigned long long nSessoes, uint32_t semente) {
+    uint32_t rng = semente ? semente : 1;
+    if (verificarCenario(&CENARIO_MANSAO) != 0) return 1;
+
+    /* fase 1: mansão embutida x montagem original */
+    ResultadoComparacao mansao;
+    memset(&mansao, 0, sizeof(mansao));
+    Sala *entrada;
+    HashTable ht;
+    montarCenarioReferencia(&entrada, &ht);
+    while (mansao.sessoes < nSessoes) {
+        unsigned long long faltam = nSessoes - mansao.sessoes;
+        int lote = faltam < LOTE_COMPARACAO ? (int)faltam : LOTE_COMPARACAO;
+        compararLote(&CENARIO_MANSAO, pistaParaSalaReferencia, NULL, entrada, &ht,
+                     lote, &rng, &mansao);
+    }
+    liberarHash(&ht);
+    liberarMansao(entrada);
+
+    /* fase 2: cenários gerados */
+    ResultadoComparacao gerados;
+    memset(&gerados, 0, sizeof(gerados));
+    static DescricaoCenario desc;
+    static TabelasGeradas tabelas;
+    unsigned long long nCenarios = 0;
+    while (gerados.sessoes < nSessoes) {
+        unsigned long long faltam = nSessoes - gerados.sessoes;
+        int lote = faltam < SESSOES_POR_CENARIO ? (int)faltam : SESSOES_POR_CENARIO;
+        gerarDescricao(&desc, &rng);
+        montarTabelasGeradas(&desc, &tabelas);
+        if (verificarCenario(&tabelas.cen) != 0) return 1;
+        entrada = montarReferenciaGerada(&desc, &ht);
+        compararLote(&tabelas.cen, pistaDescricao, &desc, entrada, &ht, lote, &rng, &gerados);
+        liberarHash(&ht);
+        liberarMansao(entrada);
+        nCenarios++;
+    }
+
+    printf("Semente %lu\n", (unsigned long)semente);
+    imprimirComparacao("Mansão embutida", &mansao);
+    char fase[64];
+    snprintf(fase, sizeof(fase), "Cenários gerados (%llu)", nCenarios);
+    imprimirComparacao(fase, &gerados);
+
+    unsigned long long divergencias = mansao.divergencias + gerados.divergencias;
+    if (divergencias) {
+        printf("%llu divergência(s) encontrada(s).\n", divergencias);
+        return 1;
+    }
+    printf("Nenhuma divergência.\n");
+    return 0;
+}
+
+/* Lê um inteiro decimal sem sinal (só dígitos) em `valor`.
+ * Retorna 0 se o texto for válido e couber em `maximo`.
+ */
+static int lerNumero(const char *texto, unsigned long long maximo, unsigned long long *valor) {
+    if (!*texto) return 1;
+    for (const char *c = texto; *c; ++c)
+        if (!isdigit((unsigned char)*c)) return 1;
+    errno = 0;
+    unsigned long long v = strtoull(texto, NULL, 10);
+    if (errno == ERANGE || v > maximo) return 1;
+    *valor = v;
+    return 0;
+}
+
+/* ----------- FUNÇÃO MAIN ---------- */
+
+/* Acrescenta a sessão ao registro aberto e fecha o arquivo.
+ * Retorna 0 se tudo foi gravado (inclusive o fechamento).
+ */
+static int gravarSessao(FILE *registro, const Sessao *sessao) {
+    fprintf(registro, "%s;%s\n", sessao->movimentos, sessao->acusado);
+    int erro = ferror(registro);
+    if (fclose(registro) != 0) erro = 1;
+    return erro ? 1 : 0;
+}
+
+/* Uso:
+ *   mestre                          jogo interativo
+ *   mestre --gravar <registro>      joga e acrescenta a sessão ao registro
+ *   mestre --analisar <registro> [threads]
+ *   mestre --comparar [sessoes] [semente]
+ */
+int main(int argc, char *argv[]) {
+    if (argc >= 3 && strcmp(argv[1], "--analisar") == 0) {
+        unsigned long long nThreads = 4;
+        if (argc >= 4 && (lerNumero(argv[3], MAX_THREADS, &nThreads) != 0 || nThreads == 0)) {
+            printf("Uso: %s --analisar <registro> [threads de 1 a %d]\n", argv[0], MAX_THREADS);
+            return 1;
+        }
+        return analisarRegistro(&CENARIO_MANSAO, argv[2], (int)nThreads);
+    }
+    if (argc >= 2 && strcmp(argv[1], "--comparar") == 0) {
+        unsigned long long nSessoes = 1000000ULL, semente = 1;
+        if ((argc >= 3 && (lerNumero(argv[2], ULLONG_MAX, &nSessoes) != 0 || nSessoes == 0))
+            || (argc >= 4 && lerNumero(argv[3], UINT32_MAX, &semente) != 0)) {
+            printf("Uso: %s --comparar [sessoes > 0] [semente < 2^32]\n", argv[0]);
+            return 1;
+        }
+        return compararImplementacoes(nSessoes, (uint32_t)semente);
+    }
+    FILE *registro = NULL;
+    if (argc >= 3 && strcmp(argv[1], "--gravar") == 0) {
+        registro = fopen(argv[2], "a");
+        if (!registro) {
+            printf("Não foi possível abrir o registro '%s'.\n", argv[2]);
+            return 1;
+        }
+    } else if (argc > 1) {
+        printf("Uso: %s [--gravar <registro> | --analisar <registro> [threads]"
+               " | --comparar [sessoes] [semente]]\n", argv[0]);
+        return 1;
+    }
+
+    /* Pistas coletadas; mansão e hash vêm prontas do cenário embutido */
+    PistaNode *pistasColetadas = NULL;
+    Sessao sessao;
+    memset(&sessao, 0, sizeof(sessao));
+    int status = 0;
 
     printf("=== Bem-vindo(a) a Detective Quest ===\n");
     printf("Seu objetivo: explorar a mansão, coletar pistas e acusar o culpado.\n");
 
     /* Exploração interativa */
-    explorarSalas(entrada, &pistasColetadas, &ht);
+    explorarSalas(&CENARIO_MANSAO, &pistasColetadas, &sessao);
 
     /* Verificação final (julgamento) */
-    verificarSuspeitoFinal(pistasColetadas, &ht);
+    verificarSuspeitoFinal(pistasColetadas, CENARIO_MANSAO.hash, &sessao);
 
-    /* liberar recursos */
+    /* liberar recursos (mansão e hash são estáticas) */
     liberarPistas(pistasColetadas);
-    liberarHash(&ht);
-    liberarMansao(entrada);
+    if (registro && gravarSessao(registro, &sessao) != 0) {
+        printf("Erro ao gravar a sessão no registro '%s'.\n", argv[2]);
+        status = 1;
+    }
 
     printf("\nObrigado por jogar Detective Quest!\n");
-    return 0;
+    return status;
 }
\ No newline at end of file